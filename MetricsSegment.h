@@ -0,0 +1,129 @@
+// MetricsSegment.h - SpadesX shared-memory metrics layout
+// The server publishes its counters and gauges (its own and those registered
+// by plugins through metric_register) in a POSIX shared-memory segment, so an
+// external exporter can read live stats without locks and without involving
+// the game thread. spadesx_metrics_dump -w provides a demo writer for testing
+// readers.
+//
+// Layout: a fixed header followed by `capacity` 64-byte slots.
+// - Only the game thread writes. A slot's name and kind are written before
+//   `count` is incremented with release ordering, so readers that load `count`
+//   with acquire ordering only ever see fully initialized slots.
+// - Each value is a single naturally aligned 64-bit word updated atomically,
+//   so a reader never sees a torn value and needs no seqlock or retry loop.
+// - `heartbeat` is incremented every tick; if it stops moving the server is
+//   stalled or gone.
+// - `magic` is written last, with release ordering, once the header is filled.
+//
+// POSIX only (Linux, macOS).
+
+#ifndef SPADESX_METRICS_SEGMENT_H
+#define SPADESX_METRICS_SEGMENT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SPADESX_METRICS_MAGIC    0x544D5853u  // "SXMT"
+#define SPADESX_METRICS_VERSION  1
+
+// Default segment name for shm_open; the server appends "-<port>" when it
+// is not listening on the default port 32887
+#define SPADESX_METRICS_SHM_NAME "/spadesx-metrics"
+
+#define SPADESX_METRICS_CAPACITY 256  // Slots in the segment
+#define SPADESX_METRICS_NAME_LEN 48   // Including the terminating NUL
+
+// Metrics a host implementing the segment publishes itself
+#define SPADESX_METRIC_PLAYERS          "server.players"           // gauge
+#define SPADESX_METRIC_TICKS            "server.ticks"             // counter
+#define SPADESX_METRIC_BLOCKS_PLACED    "server.blocks_placed"     // counter
+#define SPADESX_METRIC_BLOCKS_DESTROYED "server.blocks_destroyed"  // counter
+#define SPADESX_METRIC_ACTIONS_DENIED   "server.actions_denied"    // counter, any PLUGIN_DENY
+
+// One metric, one cache line
+typedef struct {
+    char     name[SPADESX_METRICS_NAME_LEN];
+    uint32_t kind;      // plugin_metric_kind_t
+    uint32_t reserved;
+    int64_t  value;     // Accessed atomically
+} spadesx_metric_slot_t;
+
+typedef struct {
+    uint32_t magic;       // SPADESX_METRICS_MAGIC once the segment is initialized
+    uint32_t version;     // SPADESX_METRICS_VERSION
+    uint32_t slot_size;   // sizeof(spadesx_metric_slot_t)
+    uint32_t capacity;    // Number of slots following the header
+    uint32_t count;       // Slots in use, accessed atomically
+    uint32_t pid;         // Server process ID
+    uint64_t heartbeat;   // Incremented every tick, accessed atomically
+    uint64_t reserved[4]; // Pads the header to one cache line
+} spadesx_metrics_header_t;
+
+// Total segment size for ftruncate/mmap
+#define SPADESX_METRICS_SEGMENT_SIZE(capacity) \
+    (sizeof(spadesx_metrics_header_t) + (size_t)(capacity) * sizeof(spadesx_metric_slot_t))
+
+static inline spadesx_metric_slot_t* spadesx_metrics_slots(spadesx_metrics_header_t* header)
+{
+    return (spadesx_metric_slot_t*)(header + 1);
+}
+
+// Reader side
+
+// Returns: 1 if the segment is initialized and has a layout this header understands
+static inline int spadesx_metrics_valid(const spadesx_metrics_header_t* header)
+{
+    return __atomic_load_n(&header->magic, __ATOMIC_ACQUIRE) == SPADESX_METRICS_MAGIC &&
+           header->version == SPADESX_METRICS_VERSION &&
+           header->slot_size == sizeof(spadesx_metric_slot_t);
+}
+
+static inline uint32_t spadesx_metrics_count(const spadesx_metrics_header_t* header)
+{
+    uint32_t count = __atomic_load_n(&header->count, __ATOMIC_ACQUIRE);
+    return count < header->capacity ? count : header->capacity;
+}
+
+static inline int64_t spadesx_metric_load(const spadesx_metric_slot_t* slot)
+{
+    return __atomic_load_n(&slot->value, __ATOMIC_RELAXED);
+}
+
+static inline uint64_t spadesx_metrics_heartbeat(const spadesx_metrics_header_t* header)
+{
+    return __atomic_load_n(&header->heartbeat, __ATOMIC_RELAXED);
+}
+
+// Writer side (game thread only)
+
+static inline void spadesx_metric_store(spadesx_metric_slot_t* slot, int64_t value)
+{
+    __atomic_store_n(&slot->value, value, __ATOMIC_RELAXED);
+}
+
+// Single writer, so a plain load plus atomic store is enough (no lock prefix)
+static inline void spadesx_metric_add(spadesx_metric_slot_t* slot, int64_t delta)
+{
+    __atomic_store_n(&slot->value, slot->value + delta, __ATOMIC_RELAXED);
+}
+
+static inline void spadesx_metrics_beat(spadesx_metrics_header_t* header)
+{
+    __atomic_store_n(&header->heartbeat, header->heartbeat + 1, __ATOMIC_RELAXED);
+}
+
+// Make slots [0, count) visible to readers
+static inline void spadesx_metrics_publish(spadesx_metrics_header_t* header, uint32_t count)
+{
+    __atomic_store_n(&header->count, count, __ATOMIC_RELEASE);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SPADESX_METRICS_SEGMENT_H
@@ -5,6 +5,7 @@
 #ifndef SPADESX_PLUGIN_API_H
 #define SPADESX_PLUGIN_API_H
 
+#include <stddef.h>
 #include <stdint.h>
 
 #ifdef __cplusplus
@@ -46,7 +47,15 @@ typedef struct vector3i {
 // PLUGIN METADATA
 // ============================================================================
 
+// Plugins build against version 1 by default, which current SpadesX servers
+// load. Define SPADESX_API_V2 (cmake -DSPADESX_API_V2=ON) to build against
+// version 2 instead and use the additions marked "API version 2" below; such
+// a plugin only loads on a server that implements version 2.
+#ifdef SPADESX_API_V2
+#define SPADESX_PLUGIN_API_VERSION 2
+#else
 #define SPADESX_PLUGIN_API_VERSION 1
+#endif
 
 // Plugin information structure - must be exported by every plugin
 typedef struct {
@@ -74,6 +83,101 @@ typedef struct {
     uint32_t color;    // Color as raw uint32
 } block_t;
 
+#ifdef SPADESX_API_V2
+
+// ============================================================================
+// EVENT CONTEXT (API version 2)
+// ============================================================================
+
+#define SPADESX_EVENT_CTX_VERSION 1
+
+// Snapshot of a player's state, filled once by the host per event and
+// passed to the *_v2 event handlers so they don't need to call back into
+// the API for the common fields.
+// The pointer is only valid for the duration of the handler call.
+// New fields are only ever appended; check `size` (or use
+// PLUGIN_EVENT_CTX_HAS) before reading fields newer than version 1.
+typedef struct {
+    uint32_t    version;     // SPADESX_EVENT_CTX_VERSION the host was built with
+    uint32_t    size;        // sizeof(plugin_event_ctx_t) on the host side
+    player_t*   player;      // Player the context describes (for API calls)
+    const char* name;        // Player name
+    uint8_t     player_id;   // Player ID (0-31)
+    uint8_t     team_id;     // Team ID (0, 1, or 2 for spectator)
+    uint8_t     tool;        // Current tool (TOOL_*)
+    uint8_t     hp;          // HP (0-100)
+    uint8_t     blocks;      // Block count
+    uint8_t     grenades;    // Grenade count
+    uint8_t     is_bot;      // 1 if bot, 0 if human player
+    uint8_t     reserved;    // Padding, always 0
+    uint32_t    color;       // Current tool color as raw uint32
+    uint32_t    team_color;  // Team color as raw uint32
+    vector3f_t  position;    // Position
+} plugin_event_ctx_t;
+
+// Check whether the host-filled context contains a given field
+#define PLUGIN_EVENT_CTX_HAS(ctx, field) \
+    ((ctx)->size >= offsetof(plugin_event_ctx_t, field) + sizeof((ctx)->field))
+
+// ============================================================================
+// GRENADE IMPACT (API version 2)
+// ============================================================================
+
+// Veto bitmasks hold one bit per array element, 32 elements per word
+#define PLUGIN_VETO_WORDS(count)  (((count) + 31) / 32)
+#define PLUGIN_VETO_SET(mask, i)  ((mask)[(i) >> 5] |= (uint32_t)1 << ((i) & 31))
+#define PLUGIN_VETO_TEST(mask, i) (((mask)[(i) >> 5] >> ((i) & 31)) & 1u)
+
+// Everything a grenade explosion is about to do, to be computed by the host before
+// any of it is applied. Plugins veto individual blocks or victims by setting
+// their bit; vetoes from earlier plugins are visible to later ones.
+// All pointers are only valid for the duration of the handler call.
+typedef struct {
+    uint32_t                  size;          // sizeof(plugin_grenade_impact_t) on the host side
+    vector3f_t                position;      // Explosion position
+
+    const block_t*            blocks;        // Blocks the explosion would destroy
+    uint32_t                  block_count;
+    uint32_t*                 block_veto;    // PLUGIN_VETO_WORDS(block_count) words, set bit i to keep blocks[i]
+
+    const plugin_event_ctx_t* victims;       // Players the explosion would damage
+    uint8_t*                  damage;        // Damage per victim, can be modified
+    uint32_t                  victim_count;
+    uint32_t*                 victim_veto;   // PLUGIN_VETO_WORDS(victim_count) words, set bit i to spare victims[i]
+} plugin_grenade_impact_t;
+
+// ============================================================================
+// MEMORY (API version 2)
+// ============================================================================
+
+// Host-owned bump arena (see arena_* in plugin_api_t)
+typedef struct plugin_arena plugin_arena_t;
+
+// Host-owned fixed-size object pool (see pool_* in plugin_api_t)
+typedef struct plugin_pool plugin_pool_t;
+
+// Usage report for an arena (in bytes) or a pool (in objects)
+typedef struct {
+    size_t used;        // Currently allocated
+    size_t capacity;    // Reserved, allocations beyond this make the host grow it
+    size_t high_water;  // Highest `used` since the arena/pool was created
+} plugin_alloc_stats_t;
+
+// ============================================================================
+// METRICS (API version 2)
+// ============================================================================
+
+// Kind of a metric published through metric_register
+typedef enum {
+    PLUGIN_METRIC_COUNTER = 0,  // Monotonic total, exporters derive rates from it
+    PLUGIN_METRIC_GAUGE = 1     // Current value that can go up and down
+} plugin_metric_kind_t;
+
+// Handle to a registered metric
+typedef struct plugin_metric plugin_metric_t;
+
+#endif // SPADESX_API_V2
+
 // ============================================================================
 // ERROR CODES
 // ============================================================================
@@ -293,8 +397,103 @@ typedef struct plugin_api {
     void (*log_warning)(const char* plugin_name, const char* format, ...);
     void (*log_error)(const char* plugin_name, const char* format, ...);
 
+#ifdef SPADESX_API_V2
+    // ========================================================================
+    // API VERSION 2
+    // ========================================================================
+
+    // Everything below is only present on version 2+ hosts, which are the only
+    // ones that load version 2 plugins. Functions are appended over time, so
+    // check for them with PLUGIN_API_HAS before calling.
+    uint32_t size;  // sizeof(plugin_api_t) on the host side
+
+    // ========================================================================
+    // BULK MAP FUNCTIONS (API version 2+)
+    // ========================================================================
+
+    // Read the color of `count` blocks in one call
+    // Each blocks[i].color is set to the color at (x, y, z), or 0 if no block
+    // Returns: PLUGIN_OK on success, PLUGIN_ERROR_MAP_OUT_OF_BOUNDS if any
+    //          position is invalid (its color is set to 0, the rest are still read)
+    plugin_result_t (*map_get_blocks)(map_t* map, block_t* blocks, uint32_t count);
+
+    // Set or remove `count` blocks and notify all players in a single update
+    // A color of 0 removes the block at that position
+    // Returns: PLUGIN_OK on success, PLUGIN_ERROR_MAP_OUT_OF_BOUNDS if any
+    //          position is invalid (it is skipped, the rest are still applied)
+    plugin_result_t (*map_set_blocks)(server_t* server, const block_t* blocks, uint32_t count);
+
+    // ========================================================================
+    // MEMORY FUNCTIONS (API version 2+)
+    // ========================================================================
+
+    // The host owns the memory and performs the resets described below.
+    // All of these must only be called from the game thread (event handlers).
+    // Arenas and pools are shared by every plugin; stats cover all users.
+
+    // Scratch arena, reset after every tick once all handlers have run
+    // Use it for temporary lists built during an event or on_tick
+    plugin_arena_t* (*arena_tick)(server_t* server);
+
+    // Round arena, reset when the map resets (after on_map_reset handlers)
+    plugin_arena_t* (*arena_round)(server_t* server);
+
+    // Allocate `size` bytes aligned to `align` (a power of two, 0 for default)
+    // Memory is uninitialized and is released only when the arena resets
+    // Returns: Pointer to the memory, or NULL if the allocation failed
+    void* (*arena_alloc)(plugin_arena_t* arena, size_t size, size_t align);
+
+    // Get arena usage in bytes
+    // Returns: PLUGIN_OK on success, PLUGIN_ERROR_NULL_POINTER if arena or stats is NULL
+    plugin_result_t (*arena_get_stats)(const plugin_arena_t* arena, plugin_alloc_stats_t* stats);
+
+    // Create a pool of `object_size`-byte objects, grown `objects_per_chunk` at a time
+    // Pools persist until destroyed and are not affected by tick or round resets
+    // Returns: Pointer to the pool, or NULL on failure
+    plugin_pool_t* (*pool_create)(server_t* server, size_t object_size, uint32_t objects_per_chunk);
+
+    // Destroy a pool and every object allocated from it
+    void (*pool_destroy)(server_t* server, plugin_pool_t* pool);
+
+    // Allocate one (uninitialized) object from the pool
+    // Returns: Pointer to the object, or NULL if the allocation failed
+    void* (*pool_alloc)(plugin_pool_t* pool);
+
+    // Return an object to the pool
+    void (*pool_free)(plugin_pool_t* pool, void* object);
+
+    // Get pool usage in objects
+    // Returns: PLUGIN_OK on success, PLUGIN_ERROR_NULL_POINTER if pool or stats is NULL
+    plugin_result_t (*pool_get_stats)(const plugin_pool_t* pool, plugin_alloc_stats_t* stats);
+
+    // ========================================================================
+    // METRICS FUNCTIONS (API version 2+)
+    // ========================================================================
+
+    // Metrics are published in a shared-memory segment (see MetricsSegment.h)
+    // that external tools read without touching the game thread.
+
+    // Register a metric, or get the existing one with the same name and kind
+    // name: up to 47 characters, by convention "<plugin>.<metric>"
+    // Returns: Metric handle, or NULL if the name is invalid, already used with
+    //          another kind, or the segment is full
+    plugin_metric_t* (*metric_register)(server_t* server, const char* name, plugin_metric_kind_t kind);
+
+    // Add to a metric (counters and gauges); no-op if metric is NULL
+    void (*metric_add)(plugin_metric_t* metric, int64_t delta);
+
+    // Set a gauge's value; no-op if metric is NULL
+    void (*metric_set)(plugin_metric_t* metric, int64_t value);
+#endif // SPADESX_API_V2
+
 } plugin_api_t;
 
+#ifdef SPADESX_API_V2
+// Check whether the host provides a given API function (version 2+ fields only)
+#define PLUGIN_API_HAS(api, field) \
+    ((api)->size >= offsetof(plugin_api_t, field) + sizeof((api)->field) && (api)->field != NULL)
+#endif
+
 // ============================================================================
 // PLUGIN LIFECYCLE FUNCTIONS
 // ============================================================================
@@ -371,6 +570,12 @@ typedef void (*plugin_on_grenade_explode_fn)(
 // Called every server tick (60 times per second)
 typedef void (*plugin_on_tick_fn)(server_t* server);
 
+#ifdef SPADESX_API_V2
+// Called when the map resets, before the round arena is cleared
+// Drop any pointers into the round arena here (API version 2+)
+typedef void (*plugin_on_map_reset_fn)(server_t* server);
+#endif
+
 // Called when a player hits another player
 // hit_type: 0=torso, 1=head, 2=arms, 3=legs, 4=melee
 // Return PLUGIN_ALLOW to allow the hit, PLUGIN_DENY to cancel it
@@ -391,6 +596,121 @@ typedef int (*plugin_on_color_change_fn)(
     uint32_t* new_color  // Can be modified by plugin
 );
 
+#ifdef SPADESX_API_V2
+
+// ============================================================================
+// PLUGIN EVENT HANDLERS, CONTEXT VARIANTS (Optional, API version 2+)
+// ============================================================================
+
+// Same events as above, but the host passes a pre-filled plugin_event_ctx_t
+// instead of a bare player_t*. If a plugin exports both forms of a handler,
+// only the *_v2 form is called.
+
+typedef int (*plugin_on_block_destroy_v2_fn)(
+    server_t* server,
+    const plugin_event_ctx_t* ctx,
+    uint8_t tool,
+    block_t* block
+);
+
+typedef int (*plugin_on_block_place_v2_fn)(
+    server_t* server,
+    const plugin_event_ctx_t* ctx,
+    block_t* block  // Can modify block->color
+);
+
+typedef int (*plugin_on_command_v2_fn)(
+    server_t* server,
+    const plugin_event_ctx_t* ctx,
+    const char* command
+);
+
+typedef void (*plugin_on_player_connect_v2_fn)(
+    server_t* server,
+    const plugin_event_ctx_t* ctx
+);
+
+typedef void (*plugin_on_player_disconnect_v2_fn)(
+    server_t* server,
+    const plugin_event_ctx_t* ctx,
+    const char* reason
+);
+
+typedef void (*plugin_on_grenade_explode_v2_fn)(
+    server_t* server,
+    const plugin_event_ctx_t* ctx,
+    vector3f_t position
+);
+
+typedef int (*plugin_on_player_hit_v2_fn)(
+    server_t* server,
+    const plugin_event_ctx_t* shooter,
+    const plugin_event_ctx_t* victim,
+    uint8_t hit_type,
+    uint8_t weapon
+);
+
+typedef int (*plugin_on_color_change_v2_fn)(
+    server_t* server,
+    const plugin_event_ctx_t* ctx,
+    uint32_t* new_color  // Can be modified by plugin
+);
+
+// Called once per grenade explosion with every block and player it affects
+// (API version 2+; a host implementing it must compute the affected set up
+// front, then apply the remaining blocks as a single map update)
+// Set veto bits or change damage to adjust the outcome.
+// For plugins exporting this handler, the host must not pass blocks destroyed
+// by the grenade to on_block_destroy. on_grenade_explode still follows unless denied.
+// thrower is never NULL: it is the thrower's state snapshotted when the grenade
+// was thrown, so team_id etc. stay valid even if they disconnected during the
+// fuse. In that case thrower->player is NULL and must not be passed to the API.
+// Return PLUGIN_ALLOW to apply the rest, PLUGIN_DENY to cancel the whole explosion
+typedef int (*plugin_on_grenade_impact_fn)(
+    server_t* server,
+    const plugin_event_ctx_t* thrower,  // Never NULL, snapshot taken at throw time
+    plugin_grenade_impact_t* impact
+);
+
+// ============================================================================
+// PLUGIN HANDLER TABLE (Optional, API version 2+)
+// ============================================================================
+
+// Instead of exporting each spadesx_plugin_on_* function, a plugin may export
+// a single `spadesx_plugin_handlers` table. A version 2 host must read handlers
+// from it when present, rather than looking up individual symbols, and must
+// not dispatch an event whose entry is NULL.
+typedef struct {
+    uint32_t size;  // sizeof(plugin_handlers_t) the plugin was built with
+
+    plugin_on_server_init_fn          on_server_init;
+    plugin_on_server_shutdown_fn      on_server_shutdown;
+    plugin_on_tick_fn                 on_tick;
+
+    plugin_on_block_destroy_fn        on_block_destroy;
+    plugin_on_block_place_fn          on_block_place;
+    plugin_on_command_fn              on_command;
+    plugin_on_player_connect_fn       on_player_connect;
+    plugin_on_player_disconnect_fn    on_player_disconnect;
+    plugin_on_grenade_explode_fn      on_grenade_explode;
+    plugin_on_player_hit_fn           on_player_hit;
+    plugin_on_color_change_fn         on_color_change;
+
+    plugin_on_block_destroy_v2_fn     on_block_destroy_v2;
+    plugin_on_block_place_v2_fn       on_block_place_v2;
+    plugin_on_command_v2_fn           on_command_v2;
+    plugin_on_player_connect_v2_fn    on_player_connect_v2;
+    plugin_on_player_disconnect_v2_fn on_player_disconnect_v2;
+    plugin_on_grenade_explode_v2_fn   on_grenade_explode_v2;
+    plugin_on_player_hit_v2_fn        on_player_hit_v2;
+    plugin_on_color_change_v2_fn      on_color_change_v2;
+
+    plugin_on_map_reset_fn            on_map_reset;
+    plugin_on_grenade_impact_fn       on_grenade_impact;
+} plugin_handlers_t;
+
+#endif // SPADESX_API_V2
+
 // ============================================================================
 // PLUGIN EXPORT MACROS
 // ============================================================================
@@ -437,6 +757,27 @@ typedef int (*plugin_on_color_change_fn)(
 //    PLUGIN_EXPORT int spadesx_plugin_on_player_hit(server_t* server, player_t* shooter, player_t* victim, uint8_t hit_type, uint8_t weapon) { }
 //    PLUGIN_EXPORT int spadesx_plugin_on_color_change(server_t* server, player_t* player, uint32_t* new_color) { }
 //
+//    With SPADESX_API_V2, their context variants avoid calling back into the API:
+//    PLUGIN_EXPORT int spadesx_plugin_on_block_destroy_v2(server_t* server, const plugin_event_ctx_t* ctx, uint8_t tool, block_t* block) { }
+//    PLUGIN_EXPORT int spadesx_plugin_on_block_place_v2(server_t* server, const plugin_event_ctx_t* ctx, block_t* block) { }
+//    PLUGIN_EXPORT int spadesx_plugin_on_command_v2(server_t* server, const plugin_event_ctx_t* ctx, const char* command) { }
+//    PLUGIN_EXPORT void spadesx_plugin_on_player_connect_v2(server_t* server, const plugin_event_ctx_t* ctx) { }
+//    PLUGIN_EXPORT void spadesx_plugin_on_player_disconnect_v2(server_t* server, const plugin_event_ctx_t* ctx, const char* reason) { }
+//    PLUGIN_EXPORT void spadesx_plugin_on_grenade_explode_v2(server_t* server, const plugin_event_ctx_t* ctx, vector3f_t position) { }
+//    PLUGIN_EXPORT int spadesx_plugin_on_player_hit_v2(server_t* server, const plugin_event_ctx_t* shooter, const plugin_event_ctx_t* victim, uint8_t hit_type, uint8_t weapon) { }
+//    PLUGIN_EXPORT int spadesx_plugin_on_color_change_v2(server_t* server, const plugin_event_ctx_t* ctx, uint32_t* new_color) { }
+//    PLUGIN_EXPORT int spadesx_plugin_on_grenade_impact(server_t* server, const plugin_event_ctx_t* thrower, plugin_grenade_impact_t* impact) { }
+//    PLUGIN_EXPORT void spadesx_plugin_on_map_reset(server_t* server) { }
+//
+//    Or (SPADESX_API_V2) export them all at once as a handler table (unset entries are never called):
+//    PLUGIN_EXPORT const plugin_handlers_t spadesx_plugin_handlers = {
+//        .size = sizeof(plugin_handlers_t),
+//        .on_block_place_v2 = my_block_place,
+//    };
+//
+// C++ plugins can use PluginSDK.hpp, which builds against version 2 and
+// generates all of the above.
+//
 // See plugins/example_gamemode.c for a complete working example.
 // ============================================================================
 
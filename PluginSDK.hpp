@@ -0,0 +1,724 @@
+// PluginSDK.hpp - SpadesX C++ Plugin SDK
+// Header-only C++17 layer over PluginAPI.h.
+// A plugin is a class deriving from spadesx::Plugin<Self> that implements only
+// the handlers it needs. SPADESX_PLUGIN() exports the plugin metadata, the
+// lifecycle functions and a spadesx_plugin_handlers table in which every
+// handler the class does not implement is NULL. The table is part of the
+// version 2 interface: a host implementing it can skip those events entirely.
+// The SDK therefore always builds against API version 2 (SPADESX_API_V2).
+//
+// Handlers are found by name. One that is private, protected or overloaded is
+// a compile error; a misspelled one is just another member and is never called,
+// so check names against the handler list in make_handlers().
+// With GCC, build with -fno-gnu-unique (the CMake build does): otherwise
+// static constexpr members and other inline statics keep the library loaded.
+
+#ifndef SPADESX_PLUGIN_SDK_HPP
+#define SPADESX_PLUGIN_SDK_HPP
+
+#ifndef SPADESX_API_V2
+#define SPADESX_API_V2
+#endif
+
+#include "PluginAPI.h"
+
+#if SPADESX_PLUGIN_API_VERSION < 2
+#error "PluginAPI.h was included without SPADESX_API_V2; include PluginSDK.hpp first or define SPADESX_API_V2"
+#endif
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace spadesx {
+
+// ============================================================================
+// SPAN
+// ============================================================================
+
+// Minimal non-owning view over contiguous elements (std::span is C++20)
+template <class T>
+class Span
+{
+  public:
+    constexpr Span() noexcept = default;
+    constexpr Span(T* data, std::size_t size) noexcept : data_(data), size_(size) {}
+
+    template <std::size_t N>
+    constexpr Span(T (&array)[N]) noexcept : data_(array), size_(N)
+    {
+    }
+
+    // Any container with data() and size(), e.g. std::vector or std::array
+    template <class C,
+              class = std::enable_if_t<std::is_convertible<decltype(std::declval<C&>().data()), T*>::value>>
+    constexpr Span(C& container) noexcept : data_(container.data()), size_(container.size())
+    {
+    }
+
+    constexpr T*          data() const noexcept { return data_; }
+    constexpr std::size_t size() const noexcept { return size_; }
+    constexpr bool        empty() const noexcept { return size_ == 0; }
+    constexpr T*          begin() const noexcept { return data_; }
+    constexpr T*          end() const noexcept { return data_ + size_; }
+    constexpr T&          operator[](std::size_t i) const noexcept { return data_[i]; }
+
+  private:
+    T*          data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+// ============================================================================
+// REGION
+// ============================================================================
+
+// Axis-aligned box of blocks, bounds inclusive
+// Declare regions constexpr so the checks fold into plain comparisons:
+//   static constexpr spadesx::Region platform{206, 240, 0, 306, 272, 2};
+struct Region
+{
+    int32_t x0, y0, z0;
+    int32_t x1, y1, z1;
+
+    constexpr bool contains(int32_t x, int32_t y, int32_t z) const noexcept
+    {
+        return x >= x0 && x <= x1 && y >= y0 && y <= y1 && z >= z0 && z <= z1;
+    }
+
+    constexpr bool contains(const block_t& block) const noexcept { return contains(block.x, block.y, block.z); }
+
+    constexpr bool contains(vector3f_t pos) const noexcept
+    {
+        return contains(static_cast<int32_t>(pos.x), static_cast<int32_t>(pos.y), static_cast<int32_t>(pos.z));
+    }
+};
+
+// ============================================================================
+// API WRAPPER
+// ============================================================================
+
+// Typed, inlinable wrapper around plugin_api_t
+// Cheap to copy: holds the API pointer and the plugin name used for logging.
+class Api
+{
+  public:
+    constexpr Api(const plugin_api_t* api, const char* plugin_name) noexcept : api_(api), name_(plugin_name) {}
+
+    const plugin_api_t* raw() const noexcept { return api_; }
+
+    // Functions added after version 1 may be missing on a version 2 host. The
+    // wrappers below check for them: bulk map calls fall back to the per-block
+    // version 1 calls, the others return nullptr or empty stats, or do nothing.
+
+    // Players
+
+    player_t*       player(server_t* server, uint8_t id) const { return api_->get_player(server, id); }
+    const char*     name(player_t* player) const { return api_->player_get_name(player); }
+    plugin_team_t   team(server_t* server, player_t* player) const { return api_->player_get_team(server, player); }
+    uint8_t         hp(player_t* player) const { return api_->player_get_hp(player); }
+    plugin_result_t set_hp(player_t* player, uint8_t hp) const { return api_->player_set_hp(player, hp); }
+    vector3f_t      position(player_t* player) const { return api_->player_get_position(player); }
+    plugin_result_t set_position(player_t* player, vector3f_t pos) const
+    {
+        return api_->player_set_position(player, pos);
+    }
+    plugin_result_t set_color(server_t* server, player_t* player, uint32_t color) const
+    {
+        return api_->player_set_color_broadcast(server, player, color);
+    }
+    plugin_result_t restock(player_t* player) const { return api_->player_restock(player); }
+    plugin_result_t kill(player_t* player) const { return api_->player_kill(player); }
+    plugin_result_t notice(player_t* player, const char* message) const
+    {
+        return api_->player_send_notice(player, message);
+    }
+
+    // Map
+
+    map_t*   map(server_t* server) const { return api_->get_map(server); }
+    uint32_t block(map_t* map, int32_t x, int32_t y, int32_t z) const { return api_->map_get_block(map, x, y, z); }
+    bool     valid_pos(map_t* map, int32_t x, int32_t y, int32_t z) const
+    {
+        return api_->map_is_valid_pos(map, x, y, z) != 0;
+    }
+    int32_t top_block(map_t* map, int32_t x, int32_t y) const { return api_->map_find_top_block(map, x, y); }
+
+    plugin_result_t set_block(server_t* server, int32_t x, int32_t y, int32_t z, uint32_t color) const
+    {
+        return api_->map_set_block(server, x, y, z, color);
+    }
+    plugin_result_t remove_block(server_t* server, int32_t x, int32_t y, int32_t z) const
+    {
+        return api_->map_remove_block(server, x, y, z);
+    }
+
+    // Fill in the color of every block in `blocks` with one API call
+    plugin_result_t get_blocks(map_t* map, Span<block_t> blocks) const
+    {
+        if (PLUGIN_API_HAS(api_, map_get_blocks)) {
+            return api_->map_get_blocks(map, blocks.data(), static_cast<uint32_t>(blocks.size()));
+        }
+        plugin_result_t result = PLUGIN_OK;
+        for (block_t& block : blocks) {
+            if (!api_->map_is_valid_pos(map, block.x, block.y, block.z)) {
+                block.color = 0;
+                result      = PLUGIN_ERROR_MAP_OUT_OF_BOUNDS;
+                continue;
+            }
+            block.color = api_->map_get_block(map, block.x, block.y, block.z);
+        }
+        return result;
+    }
+
+    // Apply every block in `blocks` as one map update (color 0 removes)
+    // Without map_set_blocks, each block is sent as its own update
+    plugin_result_t set_blocks(server_t* server, Span<const block_t> blocks) const
+    {
+        if (PLUGIN_API_HAS(api_, map_set_blocks)) {
+            return api_->map_set_blocks(server, blocks.data(), static_cast<uint32_t>(blocks.size()));
+        }
+        plugin_result_t result = PLUGIN_OK;
+        for (const block_t& block : blocks) {
+            plugin_result_t r = block.color ? api_->map_set_block(server, block.x, block.y, block.z, block.color)
+                                            : api_->map_remove_block(server, block.x, block.y, block.z);
+            if (r != PLUGIN_OK) {
+                result = r;
+            }
+        }
+        return result;
+    }
+
+    // Memory
+
+    // Returns: The arena, or nullptr if the server has no arenas
+    plugin_arena_t* tick_arena(server_t* server) const
+    {
+        return PLUGIN_API_HAS(api_, arena_tick) ? api_->arena_tick(server) : nullptr;
+    }
+    plugin_arena_t* round_arena(server_t* server) const
+    {
+        return PLUGIN_API_HAS(api_, arena_round) ? api_->arena_round(server) : nullptr;
+    }
+
+    // Uninitialized storage for `count` objects of T, released when the arena resets
+    // Returns: nullptr if arena is nullptr or out of memory
+    template <class T>
+    T* alloc(plugin_arena_t* arena, std::size_t count = 1) const
+    {
+        static_assert(std::is_trivially_destructible<T>::value,
+                      "arena memory is released without running destructors");
+        if (!arena || !PLUGIN_API_HAS(api_, arena_alloc)) {
+            return nullptr;
+        }
+        return static_cast<T*>(api_->arena_alloc(arena, sizeof(T) * count, alignof(T)));
+    }
+
+    // Returns: Usage, all zero if unavailable
+    plugin_alloc_stats_t stats(const plugin_arena_t* arena) const
+    {
+        plugin_alloc_stats_t stats{};
+        if (arena && PLUGIN_API_HAS(api_, arena_get_stats)) {
+            api_->arena_get_stats(arena, &stats);
+        }
+        return stats;
+    }
+
+    plugin_alloc_stats_t stats(const plugin_pool_t* pool) const
+    {
+        plugin_alloc_stats_t stats{};
+        if (pool && PLUGIN_API_HAS(api_, pool_get_stats)) {
+            api_->pool_get_stats(pool, &stats);
+        }
+        return stats;
+    }
+
+    // Metrics
+
+    // Metrics are optional: registering returns nullptr if the server lacks
+    // them, and updating a nullptr metric does nothing
+
+    plugin_metric_t* counter(server_t* server, const char* name) const
+    {
+        return has_metrics() ? api_->metric_register(server, name, PLUGIN_METRIC_COUNTER) : nullptr;
+    }
+    plugin_metric_t* gauge(server_t* server, const char* name) const
+    {
+        return has_metrics() ? api_->metric_register(server, name, PLUGIN_METRIC_GAUGE) : nullptr;
+    }
+    void add(plugin_metric_t* metric, int64_t delta = 1) const
+    {
+        if (metric) {
+            api_->metric_add(metric, delta);
+        }
+    }
+    void set(plugin_metric_t* metric, int64_t value) const
+    {
+        if (metric) {
+            api_->metric_set(metric, value);
+        }
+    }
+
+    // Server
+
+    plugin_result_t broadcast(server_t* server, const char* message) const
+    {
+        return api_->broadcast_message(server, message);
+    }
+
+    // Logging (printf-style)
+
+    template <class... Args>
+    void debug(const char* format, Args... args) const
+    {
+        api_->log_debug(name_, format, args...);
+    }
+    template <class... Args>
+    void info(const char* format, Args... args) const
+    {
+        api_->log_info(name_, format, args...);
+    }
+    template <class... Args>
+    void warning(const char* format, Args... args) const
+    {
+        api_->log_warning(name_, format, args...);
+    }
+    template <class... Args>
+    void error(const char* format, Args... args) const
+    {
+        api_->log_error(name_, format, args...);
+    }
+
+  private:
+    bool has_metrics() const
+    {
+        return PLUGIN_API_HAS(api_, metric_register) && PLUGIN_API_HAS(api_, metric_add) &&
+               PLUGIN_API_HAS(api_, metric_set);
+    }
+
+    const plugin_api_t* api_;
+    const char*         name_;
+};
+
+// ============================================================================
+// BLOCK BATCH
+// ============================================================================
+
+// Collects block changes and applies them with Api::set_blocks
+// Flushes automatically when full and when it goes out of scope:
+//   {
+//       spadesx::BlockBatch<> batch(api(), server);
+//       for (...) batch.set(x, y, z, color);
+//   }   // one map update here
+template <std::size_t Capacity = 256>
+class BlockBatch
+{
+    static_assert(Capacity > 0, "BlockBatch capacity must be non-zero");
+
+  public:
+    BlockBatch(Api api, server_t* server) noexcept : api_(api), server_(server) {}
+    ~BlockBatch() { flush(); }
+
+    BlockBatch(const BlockBatch&)            = delete;
+    BlockBatch& operator=(const BlockBatch&) = delete;
+
+    void set(int32_t x, int32_t y, int32_t z, uint32_t color)
+    {
+        if (count_ == Capacity) {
+            flush();
+        }
+        blocks_[count_++] = block_t{x, y, z, color};
+    }
+
+    void remove(int32_t x, int32_t y, int32_t z) { set(x, y, z, 0); }
+
+    // Apply pending changes now
+    // Returns: PLUGIN_OK if nothing was pending, otherwise Api::set_blocks' result
+    plugin_result_t flush()
+    {
+        if (count_ == 0) {
+            return PLUGIN_OK;
+        }
+        plugin_result_t result = api_.set_blocks(server_, Span<const block_t>(blocks_.data(), count_));
+        count_                 = 0;
+        return result;
+    }
+
+    std::size_t size() const noexcept { return count_; }
+
+  private:
+    Api                              api_;
+    server_t*                        server_;
+    std::size_t                      count_ = 0;
+    std::array<block_t, Capacity>    blocks_;
+};
+
+// ============================================================================
+// POOL
+// ============================================================================
+
+// Typed wrapper over a host object pool
+// A Pool can be a plugin member, but the API is not available while the plugin
+// object is constructed (at library load), and the host may already be gone
+// when it is destroyed (at library unload). So the pool does nothing on its
+// own: call init() from the plugin's init() and reset() from its shutdown().
+// Objects are constructed in place and must be released with destroy();
+// anything still alive at reset() is freed without running its destructor.
+template <class T>
+class Pool
+{
+    static_assert(alignof(T) <= alignof(std::max_align_t), "pool objects are only max_align_t aligned");
+
+  public:
+    constexpr Pool() noexcept = default;
+
+    Pool(const Pool&)            = delete;
+    Pool& operator=(const Pool&) = delete;
+
+    // Create the host pool
+    // Returns: true on success, false if the server has no pools or creation failed
+    bool init(Api api, server_t* server, uint32_t objects_per_chunk = 64)
+    {
+        reset();
+        const plugin_api_t* raw = api.raw();
+        if (!PLUGIN_API_HAS(raw, pool_create) || !PLUGIN_API_HAS(raw, pool_destroy) ||
+            !PLUGIN_API_HAS(raw, pool_alloc) || !PLUGIN_API_HAS(raw, pool_free) ||
+            !PLUGIN_API_HAS(raw, pool_get_stats)) {
+            return false;
+        }
+        api_    = raw;
+        server_ = server;
+        pool_   = raw->pool_create(server, sizeof(T), objects_per_chunk);
+        return pool_ != nullptr;
+    }
+
+    // Destroy the host pool and every object still allocated from it
+    void reset()
+    {
+        if (pool_) {
+            api_->pool_destroy(server_, pool_);
+            pool_ = nullptr;
+        }
+    }
+
+    explicit operator bool() const noexcept { return pool_ != nullptr; }
+
+    // Returns: The new object, or nullptr if the pool is not initialized or out of memory
+    template <class... Args>
+    T* create(Args&&... args)
+    {
+        void* memory = pool_ ? api_->pool_alloc(pool_) : nullptr;
+        return memory ? new (memory) T(std::forward<Args>(args)...) : nullptr;
+    }
+
+    void destroy(T* object)
+    {
+        if (object && pool_) {
+            object->~T();
+            api_->pool_free(pool_, object);
+        }
+    }
+
+    plugin_alloc_stats_t stats() const
+    {
+        plugin_alloc_stats_t stats{};
+        if (pool_) {
+            api_->pool_get_stats(pool_, &stats);
+        }
+        return stats;
+    }
+
+  private:
+    const plugin_api_t* api_    = nullptr;
+    server_t*           server_ = nullptr;
+    plugin_pool_t*      pool_   = nullptr;
+};
+
+// ============================================================================
+// PLUGIN BASE
+// ============================================================================
+
+#ifdef _WIN32
+#define SPADESX_SDK_LOCAL
+#else
+#define SPADESX_SDK_LOCAL __attribute__((visibility("hidden")))
+#endif
+
+namespace detail {
+
+// Per-plugin globals, defined by SPADESX_PLUGIN as explicit specializations.
+// Inline or implicitly instantiated variables would be emitted as
+// STB_GNU_UNIQUE symbols, which glibc never unloads, so a reloaded plugin
+// would keep its old instance and API pointer. Hidden, so that two plugins
+// using the same class name never share them.
+template <class P>
+struct SPADESX_SDK_LOCAL State
+{
+    static P                   instance;  // Constructed when the library is loaded
+    static const plugin_api_t* api;
+    static const char*         name;
+};
+
+} // namespace detail
+
+// CRTP base for plugins
+// Implement any of these as public members of the derived class; anything left
+// out is not exported and never dispatched:
+//   int  init(server_t* server);                       // 0 on success
+//   void shutdown(server_t* server);
+//   void on_server_init(server_t* server);
+//   void on_server_shutdown(server_t* server);
+//   void on_tick(server_t* server);
+//   void on_map_reset(server_t* server);
+//   int  on_block_destroy(server_t* server, const plugin_event_ctx_t& ctx, uint8_t tool, block_t& block);
+//   int  on_block_place(server_t* server, const plugin_event_ctx_t& ctx, block_t& block);
+//   int  on_command(server_t* server, const plugin_event_ctx_t& ctx, const char* command);
+//   void on_player_connect(server_t* server, const plugin_event_ctx_t& ctx);
+//   void on_player_disconnect(server_t* server, const plugin_event_ctx_t& ctx, const char* reason);
+//   void on_grenade_explode(server_t* server, const plugin_event_ctx_t& ctx, vector3f_t position);
+//   int  on_player_hit(server_t* server, const plugin_event_ctx_t& shooter,
+//                      const plugin_event_ctx_t& victim, uint8_t hit_type, uint8_t weapon);
+//   int  on_color_change(server_t* server, const plugin_event_ctx_t& ctx, uint32_t& new_color);
+//   int  on_grenade_impact(server_t* server, const plugin_event_ctx_t& thrower, plugin_grenade_impact_t& impact);
+//        (thrower is the throw-time snapshot; thrower.player is NULL if they disconnected)
+template <class Derived>
+class Plugin
+{
+  public:
+    static Api api() noexcept { return Api(detail::State<Derived>::api, detail::State<Derived>::name); }
+};
+
+// ============================================================================
+// DISPATCH (implementation details)
+// ============================================================================
+
+namespace detail {
+
+// has_X: P has a public, non-overloaded member X that can be bound as a handler.
+// declares_X: P declares anything named X, whatever its access. It derives from
+// P and from a probe with its own X; naming X in it is ambiguous exactly when
+// P declares one. make_handlers() requires the two to agree, so a private,
+// protected or overloaded handler is a compile error instead of silently
+// never being called.
+#define SPADESX_SDK_DETECT(handler)                                                      \
+    template <class P, class = void>                                                     \
+    struct has_##handler : std::false_type                                               \
+    {                                                                                    \
+    };                                                                                   \
+    template <class P>                                                                   \
+    struct has_##handler<P, std::void_t<decltype(&P::handler)>> : std::true_type         \
+    {                                                                                    \
+    };                                                                                   \
+    struct probe_##handler                                                               \
+    {                                                                                    \
+        int handler;                                                                     \
+    };                                                                                   \
+    template <class P>                                                                   \
+    struct probed_##handler : P, probe_##handler                                         \
+    {                                                                                    \
+    };                                                                                   \
+    template <class P, class = void>                                                     \
+    struct declares_##handler : std::true_type                                           \
+    {                                                                                    \
+    };                                                                                   \
+    template <class P>                                                                   \
+    struct declares_##handler<P, std::void_t<decltype(&probed_##handler<P>::handler)>>   \
+        : std::false_type                                                                \
+    {                                                                                    \
+    };
+
+SPADESX_SDK_DETECT(init)
+SPADESX_SDK_DETECT(shutdown)
+SPADESX_SDK_DETECT(on_server_init)
+SPADESX_SDK_DETECT(on_server_shutdown)
+SPADESX_SDK_DETECT(on_tick)
+SPADESX_SDK_DETECT(on_map_reset)
+SPADESX_SDK_DETECT(on_block_destroy)
+SPADESX_SDK_DETECT(on_block_place)
+SPADESX_SDK_DETECT(on_command)
+SPADESX_SDK_DETECT(on_player_connect)
+SPADESX_SDK_DETECT(on_player_disconnect)
+SPADESX_SDK_DETECT(on_grenade_explode)
+SPADESX_SDK_DETECT(on_player_hit)
+SPADESX_SDK_DETECT(on_color_change)
+SPADESX_SDK_DETECT(on_grenade_impact)
+
+#undef SPADESX_SDK_DETECT
+
+template <class P>
+struct Dispatch
+{
+    static int init(server_t* server, const plugin_api_t* api, const char* name)
+    {
+        State<P>::api  = api;
+        State<P>::name = name;
+        if constexpr (has_init<P>::value) {
+            return State<P>::instance.init(server);
+        } else {
+            (void) server;
+            return 0;
+        }
+    }
+
+    static void shutdown(server_t* server)
+    {
+        if constexpr (has_shutdown<P>::value) {
+            State<P>::instance.shutdown(server);
+        } else {
+            (void) server;
+        }
+    }
+
+    static void server_init(server_t* server, const plugin_api_t*) { State<P>::instance.on_server_init(server); }
+    static void server_shutdown(server_t* server) { State<P>::instance.on_server_shutdown(server); }
+    static void tick(server_t* server) { State<P>::instance.on_tick(server); }
+    static void map_reset(server_t* server) { State<P>::instance.on_map_reset(server); }
+
+    static int block_destroy(server_t* server, const plugin_event_ctx_t* ctx, uint8_t tool, block_t* block)
+    {
+        return State<P>::instance.on_block_destroy(server, *ctx, tool, *block);
+    }
+    static int block_place(server_t* server, const plugin_event_ctx_t* ctx, block_t* block)
+    {
+        return State<P>::instance.on_block_place(server, *ctx, *block);
+    }
+    static int command(server_t* server, const plugin_event_ctx_t* ctx, const char* command)
+    {
+        return State<P>::instance.on_command(server, *ctx, command);
+    }
+    static void player_connect(server_t* server, const plugin_event_ctx_t* ctx)
+    {
+        State<P>::instance.on_player_connect(server, *ctx);
+    }
+    static void player_disconnect(server_t* server, const plugin_event_ctx_t* ctx, const char* reason)
+    {
+        State<P>::instance.on_player_disconnect(server, *ctx, reason);
+    }
+    static void grenade_explode(server_t* server, const plugin_event_ctx_t* ctx, vector3f_t position)
+    {
+        State<P>::instance.on_grenade_explode(server, *ctx, position);
+    }
+    static int player_hit(server_t*                 server,
+                          const plugin_event_ctx_t* shooter,
+                          const plugin_event_ctx_t* victim,
+                          uint8_t                   hit_type,
+                          uint8_t                   weapon)
+    {
+        return State<P>::instance.on_player_hit(server, *shooter, *victim, hit_type, weapon);
+    }
+    static int color_change(server_t* server, const plugin_event_ctx_t* ctx, uint32_t* new_color)
+    {
+        return State<P>::instance.on_color_change(server, *ctx, *new_color);
+    }
+    static int grenade_impact(server_t* server, const plugin_event_ctx_t* thrower, plugin_grenade_impact_t* impact)
+    {
+        return State<P>::instance.on_grenade_impact(server, *thrower, *impact);
+    }
+};
+
+// Build the exported handler table: only implemented handlers are non-NULL
+template <class P>
+constexpr plugin_handlers_t make_handlers() noexcept
+{
+    static_assert(!std::is_final<P>::value, "spadesx: plugin classes cannot be final (handler detection derives from them)");
+
+#define SPADESX_SDK_CHECK(handler)                                                       \
+    static_assert(has_##handler<P>::value || !declares_##handler<P>::value,              \
+                  "spadesx: " #handler "() cannot be bound as a handler; make it public and don't overload it");
+
+    SPADESX_SDK_CHECK(init)
+    SPADESX_SDK_CHECK(shutdown)
+    SPADESX_SDK_CHECK(on_server_init)
+    SPADESX_SDK_CHECK(on_server_shutdown)
+    SPADESX_SDK_CHECK(on_tick)
+    SPADESX_SDK_CHECK(on_map_reset)
+    SPADESX_SDK_CHECK(on_block_destroy)
+    SPADESX_SDK_CHECK(on_block_place)
+    SPADESX_SDK_CHECK(on_command)
+    SPADESX_SDK_CHECK(on_player_connect)
+    SPADESX_SDK_CHECK(on_player_disconnect)
+    SPADESX_SDK_CHECK(on_grenade_explode)
+    SPADESX_SDK_CHECK(on_player_hit)
+    SPADESX_SDK_CHECK(on_color_change)
+    SPADESX_SDK_CHECK(on_grenade_impact)
+
+#undef SPADESX_SDK_CHECK
+
+    plugin_handlers_t h{};
+    h.size = sizeof(plugin_handlers_t);
+    if constexpr (has_on_server_init<P>::value) {
+        h.on_server_init = &Dispatch<P>::server_init;
+    }
+    if constexpr (has_on_server_shutdown<P>::value) {
+        h.on_server_shutdown = &Dispatch<P>::server_shutdown;
+    }
+    if constexpr (has_on_tick<P>::value) {
+        h.on_tick = &Dispatch<P>::tick;
+    }
+    if constexpr (has_on_map_reset<P>::value) {
+        h.on_map_reset = &Dispatch<P>::map_reset;
+    }
+    if constexpr (has_on_block_destroy<P>::value) {
+        h.on_block_destroy_v2 = &Dispatch<P>::block_destroy;
+    }
+    if constexpr (has_on_block_place<P>::value) {
+        h.on_block_place_v2 = &Dispatch<P>::block_place;
+    }
+    if constexpr (has_on_command<P>::value) {
+        h.on_command_v2 = &Dispatch<P>::command;
+    }
+    if constexpr (has_on_player_connect<P>::value) {
+        h.on_player_connect_v2 = &Dispatch<P>::player_connect;
+    }
+    if constexpr (has_on_player_disconnect<P>::value) {
+        h.on_player_disconnect_v2 = &Dispatch<P>::player_disconnect;
+    }
+    if constexpr (has_on_grenade_explode<P>::value) {
+        h.on_grenade_explode_v2 = &Dispatch<P>::grenade_explode;
+    }
+    if constexpr (has_on_player_hit<P>::value) {
+        h.on_player_hit_v2 = &Dispatch<P>::player_hit;
+    }
+    if constexpr (has_on_color_change<P>::value) {
+        h.on_color_change_v2 = &Dispatch<P>::color_change;
+    }
+    if constexpr (has_on_grenade_impact<P>::value) {
+        h.on_grenade_impact = &Dispatch<P>::grenade_impact;
+    }
+    return h;
+}
+
+} // namespace detail
+} // namespace spadesx
+
+// ============================================================================
+// PLUGIN EXPORT
+// ============================================================================
+
+// Export a plugin class. Use once, at global scope, in one source file:
+//   SPADESX_PLUGIN(MyPlugin, "My Plugin", "1.0.0", "Your Name", "What it does")
+#define SPADESX_PLUGIN(Class, Name, Version, Author, Description)                                   \
+    template <>                                                                                     \
+    Class spadesx::detail::State<Class>::instance{};                                                \
+    template <>                                                                                     \
+    const plugin_api_t* spadesx::detail::State<Class>::api = nullptr;                               \
+    template <>                                                                                     \
+    const char* spadesx::detail::State<Class>::name = nullptr;                                      \
+    extern "C" {                                                                                    \
+    PLUGIN_EXPORT plugin_info_t spadesx_plugin_info = {                                             \
+        Name, Version, Author, Description, SPADESX_PLUGIN_API_VERSION};                            \
+    PLUGIN_EXPORT extern const plugin_handlers_t spadesx_plugin_handlers;                           \
+    PLUGIN_EXPORT int spadesx_plugin_init(server_t* server, const plugin_api_t* api)                \
+    {                                                                                               \
+        return ::spadesx::detail::Dispatch<Class>::init(server, api, spadesx_plugin_info.name);     \
+    }                                                                                               \
+    PLUGIN_EXPORT void spadesx_plugin_shutdown(server_t* server)                                    \
+    {                                                                                               \
+        ::spadesx::detail::Dispatch<Class>::shutdown(server);                                       \
+    }                                                                                               \
+    }                                                                                               \
+    const plugin_handlers_t spadesx_plugin_handlers = ::spadesx::detail::make_handlers<Class>();
+
+#endif // SPADESX_PLUGIN_SDK_HPP
@@ -0,0 +1,269 @@
+// metrics_dump.c - Dump a running SpadesX server's metrics segment
+// Maps the shared-memory segment read-only and prints every metric. It never
+// locks anything and never signals the server, so it is safe to run (or poll)
+// against a live server.
+//
+// With -w it instead plays the server's role: it creates the segment and
+// updates a few demo metrics at tick rate, so the reader (or an exporter) can
+// be tried on a single machine without a server that implements metrics.
+//
+// Usage:
+//   spadesx_metrics_dump [-n shm_name] [-i seconds]
+//   spadesx_metrics_dump -w [-n shm_name] [-t seconds]
+//     -n  Segment name (default: /spadesx-metrics)
+//     -i  Print again every N seconds until interrupted, re-opening the
+//         segment if the server restarts or its heartbeat stops
+//     -w  Demo writer: create the segment and update it until interrupted
+//     -t  Stop the demo writer after N seconds (and remove the segment)
+
+#define _POSIX_C_SOURCE 200809L
+#define SPADESX_API_V2  // plugin_metric_kind_t
+
+#include "MetricsSegment.h"
+#include "PluginAPI.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+static volatile sig_atomic_t running = 1;
+
+static void stop(int sig)
+{
+    (void) sig;
+    running = 0;
+}
+
+static const char* kind_name(uint32_t kind)
+{
+    switch (kind) {
+        case PLUGIN_METRIC_COUNTER:
+            return "counter";
+        case PLUGIN_METRIC_GAUGE:
+            return "gauge";
+        default:
+            return "unknown";
+    }
+}
+
+static void dump(const spadesx_metrics_header_t* header)
+{
+    const spadesx_metric_slot_t* slots = spadesx_metrics_slots((spadesx_metrics_header_t*) header);
+    uint32_t                     count = spadesx_metrics_count(header);
+
+    printf("# pid %u, heartbeat %llu, %u metrics\n",
+           header->pid,
+           (unsigned long long) spadesx_metrics_heartbeat(header),
+           count);
+
+    for (uint32_t i = 0; i < count; i++) {
+        char name[SPADESX_METRICS_NAME_LEN];
+        memcpy(name, slots[i].name, sizeof(name));
+        name[sizeof(name) - 1] = '\0';
+
+        printf("%-7s %-47s %lld\n", kind_name(slots[i].kind), name, (long long) spadesx_metric_load(&slots[i]));
+    }
+    fflush(stdout);
+}
+
+// Map a server's segment read-only
+// Returns: The header (size in *size), or NULL after printing why it failed
+static const spadesx_metrics_header_t* open_segment(const char* shm_name, size_t* size)
+{
+    int fd = shm_open(shm_name, O_RDONLY, 0);
+    if (fd < 0) {
+        fprintf(stderr, "shm_open(%s): %s\n", shm_name, strerror(errno));
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t) st.st_size < sizeof(spadesx_metrics_header_t)) {
+        fprintf(stderr, "%s: segment too small\n", shm_name);
+        close(fd);
+        return NULL;
+    }
+
+    void* memory = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED) {
+        fprintf(stderr, "mmap(%s): %s\n", shm_name, strerror(errno));
+        return NULL;
+    }
+
+    const spadesx_metrics_header_t* header = memory;
+    if (!spadesx_metrics_valid(header) ||
+        (size_t) st.st_size < SPADESX_METRICS_SEGMENT_SIZE(header->capacity)) {
+        fprintf(stderr, "%s: not a SpadesX metrics segment (or unsupported version)\n", shm_name);
+        munmap(memory, (size_t) st.st_size);
+        return NULL;
+    }
+
+    *size = (size_t) st.st_size;
+    return header;
+}
+
+// Fill slot `index` with a metric, before it is published
+static spadesx_metric_slot_t*
+demo_slot(spadesx_metrics_header_t* header, uint32_t index, const char* name, plugin_metric_kind_t kind)
+{
+    spadesx_metric_slot_t* slot = &spadesx_metrics_slots(header)[index];
+    strncpy(slot->name, name, sizeof(slot->name) - 1);
+    slot->kind = (uint32_t) kind;
+    return slot;
+}
+
+// Demo writer: do what a server does with the segment, at 60 ticks per second
+static int write_demo(const char* shm_name, int duration)
+{
+    size_t size = SPADESX_METRICS_SEGMENT_SIZE(SPADESX_METRICS_CAPACITY);
+
+    int fd = shm_open(shm_name, O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "shm_open(%s): %s\n", shm_name, strerror(errno));
+        return 1;
+    }
+    if (ftruncate(fd, (off_t) size) != 0) {
+        fprintf(stderr, "ftruncate(%s): %s\n", shm_name, strerror(errno));
+        close(fd);
+        shm_unlink(shm_name);
+        return 1;
+    }
+
+    void* memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED) {
+        fprintf(stderr, "mmap(%s): %s\n", shm_name, strerror(errno));
+        shm_unlink(shm_name);
+        return 1;
+    }
+
+    // ftruncate zero-fills, so only the non-zero fields need writing; magic goes last
+    spadesx_metrics_header_t* header = memory;
+    header->version                  = SPADESX_METRICS_VERSION;
+    header->slot_size                = sizeof(spadesx_metric_slot_t);
+    header->capacity                 = SPADESX_METRICS_CAPACITY;
+    header->pid                      = (uint32_t) getpid();
+    __atomic_store_n(&header->magic, SPADESX_METRICS_MAGIC, __ATOMIC_RELEASE);
+
+    spadesx_metric_slot_t* players = demo_slot(header, 0, SPADESX_METRIC_PLAYERS, PLUGIN_METRIC_GAUGE);
+    spadesx_metric_slot_t* ticks   = demo_slot(header, 1, SPADESX_METRIC_TICKS, PLUGIN_METRIC_COUNTER);
+    spadesx_metric_slot_t* placed  = demo_slot(header, 2, SPADESX_METRIC_BLOCKS_PLACED, PLUGIN_METRIC_COUNTER);
+    spadesx_metric_slot_t* denied  = demo_slot(header, 3, "demo.denied_actions", PLUGIN_METRIC_COUNTER);
+    spadesx_metrics_publish(header, 4);
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = stop;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    printf("Writing demo metrics to %s, press Ctrl+C to stop\n", shm_name);
+    fflush(stdout);
+
+    const struct timespec tick_time = {0, 1000000000L / 60};
+    for (uint64_t tick = 1; running && (duration <= 0 || tick <= (uint64_t) duration * 60); tick++) {
+        spadesx_metric_add(ticks, 1);
+        spadesx_metric_store(players, (int64_t) ((tick / 60) % 16));
+        if (tick % 7 == 0) {
+            spadesx_metric_add(placed, 1);
+        }
+        if (tick % 90 == 0) {
+            spadesx_metric_add(denied, 1);
+        }
+        spadesx_metrics_beat(header);
+        nanosleep(&tick_time, NULL);
+    }
+
+    munmap(memory, size);
+    shm_unlink(shm_name);
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    const char* shm_name = SPADESX_METRICS_SHM_NAME;
+    int         interval = 0;
+    int         writer   = 0;
+    int         duration = 0;
+    int         opt;
+
+    while ((opt = getopt(argc, argv, "n:i:wt:h")) != -1) {
+        switch (opt) {
+            case 'n':
+                shm_name = optarg;
+                break;
+            case 'i':
+                interval = atoi(optarg);
+                break;
+            case 'w':
+                writer = 1;
+                break;
+            case 't':
+                duration = atoi(optarg);
+                break;
+            default:
+                fprintf(stderr,
+                        "Usage: %s [-n shm_name] [-i seconds]\n"
+                        "       %s -w [-n shm_name] [-t seconds]\n",
+                        argv[0],
+                        argv[0]);
+                return opt == 'h' ? 0 : 2;
+        }
+    }
+
+    if (writer) {
+        return write_demo(shm_name, duration);
+    }
+
+    size_t                          size;
+    const spadesx_metrics_header_t* header = open_segment(shm_name, &size);
+    if (!header) {
+        return 1;
+    }
+    dump(header);
+
+    // A restarted server creates a new segment under the same name, while this
+    // mapping keeps the old one; a stalled server stops the heartbeat. Either
+    // way the heartbeat stops moving here, so then map the name again.
+    uint32_t pid       = header->pid;
+    uint64_t heartbeat = spadesx_metrics_heartbeat(header);
+
+    while (interval > 0) {
+        sleep((unsigned int) interval);
+
+        if (header && (!spadesx_metrics_valid(header) || header->pid != pid ||
+                       spadesx_metrics_heartbeat(header) == heartbeat)) {
+            munmap((void*) header, size);
+            header = NULL;
+        }
+        if (!header) {
+            header = open_segment(shm_name, &size);
+            if (!header) {
+                continue; // Not there (yet), try again next interval
+            }
+            if (header->pid != pid) {
+                fprintf(stderr, "%s: server restarted (pid %u, was %u)\n", shm_name, header->pid, pid);
+                pid = header->pid;
+            } else if (spadesx_metrics_heartbeat(header) == heartbeat) {
+                fprintf(stderr,
+                        "%s: heartbeat stopped at %llu, server stalled\n",
+                        shm_name,
+                        (unsigned long long) heartbeat);
+            }
+        }
+        heartbeat = spadesx_metrics_heartbeat(header);
+
+        printf("\n");
+        dump(header);
+    }
+
+    munmap((void*) header, size);
+    return 0;
+}
@@ -4,6 +4,7 @@
 // Features:
 // - Prevents destroying the Babel platform (206-306, 240-272, z=0-2)
 // - Prevents teams from destroying their own towers (except with spade)
+// - Applies the same protection to grenade explosions, one call per explosion (API version 2)
 // - Forces players to build in their team color
 // - Auto-restocks players when blocks < 10
 // - Adds /restock command
@@ -11,6 +12,7 @@
 
 #include "PluginAPI.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 // Plugin metadata
@@ -26,38 +28,138 @@ PLUGIN_EXPORT plugin_info_t spadesx_plugin_info = {
 static const plugin_api_t* api = NULL;
 static const char* PLUGIN_NAME = "Example Gamemode";
 
-// Track blocks above players
-typedef struct {
-    uint8_t player_id;
+// Track blocks above players, one tracker per connected player
+typedef struct player_block_tracker {
+    struct player_block_tracker* next;
+    player_t* player;
     int32_t block_x;
     int32_t block_y;
     int32_t block_z;
     uint8_t has_block;
 } player_block_tracker_t;
 
-static player_block_tracker_t player_blocks[32]; // Max 32 players
+#define MAX_PLAYERS 32
+
+static player_block_tracker_t* trackers = NULL;
+static uint32_t tracker_count = 0;
 static int tick_counter = 0; // For debug logging
 
+#ifdef SPADESX_API_V2
+// Trackers come from this pool when the server provides pools, else from the heap
+static plugin_pool_t* tracker_pool = NULL;
+
+static int arena_error_logged = 0; // Log tick arena exhaustion once per outage
+
+// Number of actions this plugin denied, published to the metrics segment
+static plugin_metric_t* denied_metric = NULL;
+#endif
+
 // Bot player references
 static player_t* bot_team_0 = NULL;
 static player_t* bot_team_1 = NULL;
 
+// Babel platform: z=0 and z=2 on the inner area, z=1 one block wider
+static int is_platform(int32_t x, int32_t y, int32_t z)
+{
+    return ((x >= 206 && x <= 306) && (y >= 240 && y <= 272) && (z == 2 || z == 0)) ||
+           ((x >= 205 && x <= 307) && (y >= 239 && y <= 273) && (z == 1));
+}
+
+// Team 1 tower is on the right (x > 512-220 = 292)
+// Team 0 tower is on the left (x < 220)
+static int is_own_tower_side(uint8_t team_id, int32_t x)
+{
+    return (team_id == 1 && x > 292) || (team_id == 0 && x < 220);
+}
+
+// Start tracking a player's trail (connect and bot creation, not per tick)
+static void track_player(player_t* player)
+{
+    for (player_block_tracker_t* t = trackers; t; t = t->next) {
+        if (t->player == player) {
+            return;
+        }
+    }
+
+    player_block_tracker_t* tracker = NULL;
+#ifdef SPADESX_API_V2
+    if (tracker_pool) {
+        tracker = api->pool_alloc(tracker_pool);
+    } else
+#endif
+    {
+        tracker = malloc(sizeof(*tracker));
+    }
+    if (!tracker) {
+        api->log_error(PLUGIN_NAME, "Out of memory, no trail for %s", api->player_get_name(player));
+        return;
+    }
+
+    tracker->player    = player;
+    tracker->has_block = 0;
+    tracker->next      = trackers;
+    trackers           = tracker;
+    tracker_count++;
+}
+
+static void free_tracker(player_block_tracker_t* tracker)
+{
+#ifdef SPADESX_API_V2
+    if (tracker_pool) {
+        api->pool_free(tracker_pool, tracker);
+        return;
+    }
+#endif
+    free(tracker);
+}
+
+// Stop tracking a player, leaving their trail on the map
+static void untrack_player(player_t* player)
+{
+    for (player_block_tracker_t** link = &trackers; *link; link = &(*link)->next) {
+        player_block_tracker_t* tracker = *link;
+        if (tracker->player == player) {
+            *link = tracker->next;
+            free_tracker(tracker);
+            tracker_count--;
+            return;
+        }
+    }
+}
+
+// Publish a denied action, if the server supports metrics
+static void count_denied(void)
+{
+#ifdef SPADESX_API_V2
+    if (denied_metric) {
+        api->metric_add(denied_metric, 1);
+    }
+#endif
+}
+
 // ============================================================================
 // PLUGIN LIFECYCLE
 // ============================================================================
 
 PLUGIN_EXPORT int spadesx_plugin_init(server_t* server, const plugin_api_t* plugin_api)
 {
-    (void)server;  // Unused
     api = plugin_api;
     api->log_info(PLUGIN_NAME, "Initializing...");
     api->log_debug(PLUGIN_NAME, "API pointer: %p", (void*)plugin_api);
 
-    // Initialize player block tracking
-    for (int i = 0; i < 32; i++) {
-        player_blocks[i].player_id = i;
-        player_blocks[i].has_block = 0;
+#ifdef SPADESX_API_V2
+    // Pools, arenas and metrics are all optional, see spadesx_plugin_on_tick
+    if (PLUGIN_API_HAS(api, pool_create) && PLUGIN_API_HAS(api, pool_destroy) &&
+        PLUGIN_API_HAS(api, pool_alloc) && PLUGIN_API_HAS(api, pool_free)) {
+        tracker_pool = api->pool_create(server, sizeof(player_block_tracker_t), MAX_PLAYERS);
+    }
+
+    if (PLUGIN_API_HAS(api, metric_register) && PLUGIN_API_HAS(api, metric_add)) {
+        denied_metric = api->metric_register(server, "babel.denied_actions", PLUGIN_METRIC_COUNTER);
     }
+#else
+    (void) server;
+#endif
 
     api->log_info(PLUGIN_NAME, "Loaded successfully! Player trail feature enabled.");
     return 0;
@@ -65,7 +167,21 @@ PLUGIN_EXPORT int spadesx_plugin_init(server_t* server, const plugin_api_t* plug
 
 PLUGIN_EXPORT void spadesx_plugin_shutdown(server_t* server)
 {
+    while (trackers) {
+        player_block_tracker_t* next = trackers->next;
+        free_tracker(trackers);
+        trackers = next;
+    }
+    tracker_count = 0;
+
+#ifdef SPADESX_API_V2
+    if (tracker_pool) {
+        api->pool_destroy(server, tracker_pool);
+        tracker_pool = NULL;
+    }
+#else
     (void)server;  // Unused
+#endif
     api->log_info(PLUGIN_NAME, "Shutting down");
 }
 
@@ -104,6 +220,7 @@ PLUGIN_EXPORT void spadesx_plugin_on_server_init(server_t* server, const plugin_
     bot_team_0 = api->bot_create(server, "Bot_Blue", 0, 0);  // Team 0 (Blue), Rifle
     if (bot_team_0) {
         api->log_info(PLUGIN_NAME, "Created bot for team 0: %s", api->player_get_name(bot_team_0));
+        track_player(bot_team_0);
     } else {
         api->log_error(PLUGIN_NAME, "Failed to create bot for team 0");
     }
@@ -111,6 +228,7 @@ PLUGIN_EXPORT void spadesx_plugin_on_server_init(server_t* server, const plugin_
     bot_team_1 = api->bot_create(server, "Bot_Green", 1, 1);  // Team 1 (Green), SMG
     if (bot_team_1) {
         api->log_info(PLUGIN_NAME, "Created bot for team 1: %s", api->player_get_name(bot_team_1));
+        track_player(bot_team_1);
     } else {
         api->log_error(PLUGIN_NAME, "Failed to create bot for team 1");
     }
@@ -118,20 +236,16 @@ PLUGIN_EXPORT void spadesx_plugin_on_server_init(server_t* server, const plugin_
     api->log_info(PLUGIN_NAME, "Map initialization complete!");
 }
 
+// The checks below are shared by the version 1 and version 2 exports at the
+// end of this file, which only differ in where the player state comes from.
+
 // Block destruction check
-PLUGIN_EXPORT int spadesx_plugin_on_block_destroy(server_t* server, player_t* player, uint8_t tool, block_t* block)
+static int check_block_destroy(player_t* player, uint8_t team_id, uint8_t tool, const block_t* block)
 {
-    int32_t x = block->x;
-    int32_t y = block->y;
-    int32_t z = block->z;
-
     // Prevent destroying the Babel platform
-    int is_platform =
-        ((x >= 206 && x <= 306) && (y >= 240 && y <= 272) && (z == 2 || z == 0)) ||
-        ((x >= 205 && x <= 307) && (y >= 239 && y <= 273) && (z == 1));
-
-    if (is_platform) {
+    if (is_platform(block->x, block->y, block->z)) {
         api->player_send_notice(player, "You should try to destroy the ennemy's tower... Not the platform!");
+        count_denied();
         return PLUGIN_DENY;
     }
 
@@ -141,12 +255,9 @@ PLUGIN_EXPORT int spadesx_plugin_on_block_destroy(server_t* server, player_t* pl
     }
 
     // Prevent teams from destroying their own towers
-    plugin_team_t team = api->player_get_team(server, player);
-
-    // Team 1 tower is on the right (x > 512-220 = 292)
-    // Team 0 tower is on the left (x < 220)
-    if ((team.id == 1 && x > 292) || (team.id == 0 && x < 220)) {
+    if (is_own_tower_side(team_id, block->x)) {
         api->player_send_notice(player, "You should try to destroy the ennemy's tower... It is not on this side of the map!");
+        count_denied();
         return PLUGIN_DENY;
     }
 
@@ -154,23 +265,25 @@ PLUGIN_EXPORT int spadesx_plugin_on_block_destroy(server_t* server, player_t* pl
 }
 
 // Block placement check
-PLUGIN_EXPORT int spadesx_plugin_on_block_place(server_t* server, player_t* player, block_t* block)
+static int check_block_place(server_t* server,
+                             player_t* player,
+                             uint32_t  team_color,
+                             uint32_t  player_color,
+                             uint8_t   blocks,
+                             block_t*  block)
 {
-    plugin_team_t team = api->player_get_team(server, player);
-    uint32_t player_color = api->player_get_color(player);
-
     // Force block to be placed in team color
-    if (block->color != team.color) {
-        block->color = team.color;
+    if (block->color != team_color) {
+        block->color = team_color;
     }
 
     // Update the player's tool color if it's wrong and broadcast to all clients
-    if (player_color != team.color) {
-        api->player_set_color_broadcast(server, player, team.color);
+    if (player_color != team_color) {
+        api->player_set_color_broadcast(server, player, team_color);
     }
 
     // Auto restock when blocks are low
-    if (api->player_get_blocks(player) < 10) {
+    if (blocks < 10) {
         api->player_restock(player);
     }
 
@@ -178,9 +291,8 @@ PLUGIN_EXPORT int spadesx_plugin_on_block_place(server_t* server, player_t* play
 }
 
 // Command handler
-PLUGIN_EXPORT int spadesx_plugin_on_command(server_t* server, player_t* player, const char* command)
+static int handle_command(player_t* player, const char* command)
 {
-    (void) server;
     if (strcmp(command, "/restock") == 0) {
         api->player_restock(player);
         api->player_send_notice(player, "Restocked!");
@@ -191,11 +303,10 @@ PLUGIN_EXPORT int spadesx_plugin_on_command(server_t* server, player_t* player,
 }
 
 // Player connect
-PLUGIN_EXPORT void spadesx_plugin_on_player_connect(server_t* server, player_t* player)
+static void welcome_player(player_t* player, const char* name)
 {
-    (void) server;
-    const char* name = api->player_get_name(player);
     api->log_info(PLUGIN_NAME, "Player %s connected", name);
+    track_player(player);
 
     // Welcome the player
     api->player_send_notice(player, "Welcome to the Babel-style server!");
@@ -203,24 +314,9 @@ PLUGIN_EXPORT void spadesx_plugin_on_player_connect(server_t* server, player_t*
     api->player_send_notice(player, "Headshots only mode enabled!");
 }
 
-// Player disconnect
-PLUGIN_EXPORT void spadesx_plugin_on_player_disconnect(server_t* server, player_t* player, const char* reason)
-{
-    (void)server;
-    const char* name = api->player_get_name(player);
-    api->log_info(PLUGIN_NAME, "Player %s disconnected: %s", name, reason);
-    // Leave the trail behind - don't remove blocks
-}
-
-// Player hit handler - only allow headshots
-PLUGIN_EXPORT int
-spadesx_plugin_on_player_hit(server_t* server, player_t* shooter, player_t* victim, uint8_t hit_type, uint8_t weapon)
+// Player hit check - only allow headshots
+static int check_player_hit(player_t* shooter, const char* shooter_name, const char* victim_name, uint8_t hit_type)
 {
-    (void) server;
-    (void) weapon;
-
-    const char* shooter_name = api->player_get_name(shooter);
-    const char* victim_name  = api->player_get_name(victim);
     const char* hit_location;
 
     // Get hit location name
@@ -249,6 +345,7 @@ spadesx_plugin_on_player_hit(server_t* server, player_t* shooter, player_t* vict
 
     if (hit_type != 1 && hit_type != 4) { // 1=head, 4=melee
         api->player_send_notice(shooter, "Headshots only!");
+        count_denied();
         return PLUGIN_DENY;
     }
 
@@ -261,20 +358,30 @@ PLUGIN_EXPORT void spadesx_plugin_on_tick(server_t* server)
 {
     tick_counter++;
 
-
-    // Iterate through all possible player IDs
-    for (uint8_t i = 0; i < 32; i++) {
-        player_t* player = api->get_player(server, i);
-
-        // Skip if player doesn't exist or is dead
-        if (!player) {
-            // Just reset tracking, don't remove blocks (leave the trail)
-            player_blocks[i].has_block = 0;
-            continue;
+    map_t*   map     = api->get_map(server);
+    block_t* changed = NULL; // This tick's trail blocks, sent as one update if set
+    uint32_t count   = 0;
+
+#ifdef SPADESX_API_V2
+    // The number of players varies, so collect the trail blocks in the scratch
+    // arena (freed by the server after the tick) and send them in a single map
+    // update. Without arenas or map_set_blocks, send them one by one instead.
+    plugin_arena_t* arena = PLUGIN_API_HAS(api, arena_tick) ? api->arena_tick(server) : NULL;
+
+    if (arena && tracker_count > 0 && PLUGIN_API_HAS(api, arena_alloc) && PLUGIN_API_HAS(api, map_set_blocks)) {
+        changed = api->arena_alloc(arena, tracker_count * sizeof(block_t), _Alignof(block_t));
+        if (changed) {
+            arena_error_logged = 0;
+        } else if (!arena_error_logged) {
+            api->log_warning(PLUGIN_NAME, "Out of tick arena memory, sending trail blocks one by one");
+            arena_error_logged = 1;
         }
+    }
+#endif
 
+    for (player_block_tracker_t* tracker = trackers; tracker; tracker = tracker->next) {
         // Get player position
-        vector3f_t pos = api->player_get_position(player);
+        vector3f_t pos = api->player_get_position(tracker->player);
 
 
         // Calculate block position (3 meters above player's head)
@@ -285,10 +392,10 @@ PLUGIN_EXPORT void spadesx_plugin_on_tick(server_t* server)
 
         // Check if block position changed
         int position_changed = 0;
-        if (player_blocks[i].has_block) {
-            if (player_blocks[i].block_x != block_x ||
-                player_blocks[i].block_y != block_y ||
-                player_blocks[i].block_z != block_z) {
+        if (tracker->has_block) {
+            if (tracker->block_x != block_x ||
+                tracker->block_y != block_y ||
+                tracker->block_z != block_z) {
                 position_changed = 1;
             }
         } else {
@@ -296,23 +403,161 @@ PLUGIN_EXPORT void spadesx_plugin_on_tick(server_t* server)
         }
 
         // Only place block if position changed (leave trail behind)
-        if (position_changed) {
-            map_t* map = api->get_map(server);
-            if (api->map_is_valid_pos(map, block_x, block_y, block_z)) {
-                // Use a bright color (yellow) so it's easy to see
-                uint32_t color = 0xFFFFFF00; // Yellow (ARGB format)
-
-                api->map_set_block(server, block_x, block_y, block_z, color);
-
-                // Update tracking
-                player_blocks[i].block_x = block_x;
-                player_blocks[i].block_y = block_y;
-                player_blocks[i].block_z = block_z;
-                player_blocks[i].has_block = 1;
+        if (position_changed && api->map_is_valid_pos(map, block_x, block_y, block_z)) {
+            // Use a bright color (yellow) so it's easy to see
+            if (changed) {
+                changed[count].x     = block_x;
+                changed[count].y     = block_y;
+                changed[count].z     = block_z;
+                changed[count].color = 0xFFFFFF00; // Yellow (ARGB format)
+                count++;
             } else {
+                api->map_set_block(server, block_x, block_y, block_z, 0xFFFFFF00); // Yellow (ARGB format)
             }
+
+            // Update tracking
+            tracker->block_x = block_x;
+            tracker->block_y = block_y;
+            tracker->block_z = block_z;
+            tracker->has_block = 1;
+        }
+    }
+
+#ifdef SPADESX_API_V2
+    if (count > 0) {
+        api->map_set_blocks(server, changed, count);
+    }
+
+    // Report scratch memory usage every minute
+    if (arena && tick_counter % 3600 == 0 && PLUGIN_API_HAS(api, arena_get_stats)) {
+        plugin_alloc_stats_t stats;
+        if (api->arena_get_stats(arena, &stats) == PLUGIN_OK) {
+            api->log_debug(PLUGIN_NAME, "Tick arena: %zu/%zu bytes, peak %zu",
+                           stats.used, stats.capacity, stats.high_water);
+        }
+    }
+#endif
+}
+
+// ============================================================================
+// EXPORTED EVENT HANDLERS
+// ============================================================================
+
+#ifdef SPADESX_API_V2
+
+// Version 2 servers pass a pre-filled event context, so no lookups are needed
+
+PLUGIN_EXPORT int
+spadesx_plugin_on_block_destroy_v2(server_t* server, const plugin_event_ctx_t* ctx, uint8_t tool, block_t* block)
+{
+    (void) server;
+    return check_block_destroy(ctx->player, ctx->team_id, tool, block);
+}
+
+PLUGIN_EXPORT int spadesx_plugin_on_block_place_v2(server_t* server, const plugin_event_ctx_t* ctx, block_t* block)
+{
+    return check_block_place(server, ctx->player, ctx->team_color, ctx->color, ctx->blocks, block);
+}
+
+// Grenade impact check - same protection as on_block_destroy, one call per explosion
+PLUGIN_EXPORT int
+spadesx_plugin_on_grenade_impact(server_t* server, const plugin_event_ctx_t* thrower, plugin_grenade_impact_t* impact)
+{
+    (void) server;
+    int vetoed = 0;
+
+    for (uint32_t i = 0; i < impact->block_count; i++) {
+        const block_t* block = &impact->blocks[i];
+        if (is_platform(block->x, block->y, block->z) || is_own_tower_side(thrower->team_id, block->x)) {
+            PLUGIN_VETO_SET(impact->block_veto, i);
+            vetoed = 1;
         }
     }
+
+    // One denied action per explosion, however many blocks it kept
+    if (vetoed) {
+        count_denied();
+    }
+
+    return PLUGIN_ALLOW;
+}
+
+PLUGIN_EXPORT int spadesx_plugin_on_command_v2(server_t* server, const plugin_event_ctx_t* ctx, const char* command)
+{
+    (void) server;
+    return handle_command(ctx->player, command);
+}
+
+PLUGIN_EXPORT void spadesx_plugin_on_player_connect_v2(server_t* server, const plugin_event_ctx_t* ctx)
+{
+    (void) server;
+    welcome_player(ctx->player, ctx->name);
+}
+
+PLUGIN_EXPORT void
+spadesx_plugin_on_player_disconnect_v2(server_t* server, const plugin_event_ctx_t* ctx, const char* reason)
+{
+    (void)server;
+    api->log_info(PLUGIN_NAME, "Player %s disconnected: %s", ctx->name, reason);
+    // Leave the trail behind - don't remove blocks
+    untrack_player(ctx->player);
+}
+
+PLUGIN_EXPORT int spadesx_plugin_on_player_hit_v2(server_t*                 server,
+                                                 const plugin_event_ctx_t* shooter,
+                                                 const plugin_event_ctx_t* victim,
+                                                 uint8_t                   hit_type,
+                                                 uint8_t                   weapon)
+{
+    (void) server;
+    (void) weapon;
+    return check_player_hit(shooter->player, shooter->name, victim->name, hit_type);
+}
+
+#else
+
+// Version 1 servers pass the player, so the checks look up what they need
+
+PLUGIN_EXPORT int spadesx_plugin_on_block_destroy(server_t* server, player_t* player, uint8_t tool, block_t* block)
+{
+    return check_block_destroy(player, api->player_get_team(server, player).id, tool, block);
+}
+
+PLUGIN_EXPORT int spadesx_plugin_on_block_place(server_t* server, player_t* player, block_t* block)
+{
+    plugin_team_t team = api->player_get_team(server, player);
+    return check_block_place(
+        server, player, team.color, api->player_get_color(player), api->player_get_blocks(player), block);
+}
+
+PLUGIN_EXPORT int spadesx_plugin_on_command(server_t* server, player_t* player, const char* command)
+{
+    (void) server;
+    return handle_command(player, command);
 }
 
+PLUGIN_EXPORT void spadesx_plugin_on_player_connect(server_t* server, player_t* player)
+{
+    (void) server;
+    welcome_player(player, api->player_get_name(player));
+}
+
+PLUGIN_EXPORT void spadesx_plugin_on_player_disconnect(server_t* server, player_t* player, const char* reason)
+{
+    (void)server;
+    api->log_info(PLUGIN_NAME, "Player %s disconnected: %s", api->player_get_name(player), reason);
+    // Leave the trail behind - don't remove blocks
+    untrack_player(player);
+}
+
+PLUGIN_EXPORT int
+spadesx_plugin_on_player_hit(server_t* server, player_t* shooter, player_t* victim, uint8_t hit_type, uint8_t weapon)
+{
+    (void) server;
+    (void) weapon;
+    return check_player_hit(shooter, api->player_get_name(shooter), api->player_get_name(victim), hit_type);
+}
+
+#endif // SPADESX_API_V2
+
 // All functions are exported directly with PLUGIN_EXPORT above
@@ -0,0 +1,237 @@
+// template_plugin.cpp - Example SpadesX plugin using the C++ SDK
+// Same Babel-style rules as template_plugin.c, written against PluginSDK.hpp.
+//
+// Features:
+// - Prevents destroying the Babel platform
+// - Prevents teams from destroying their own towers (except with spade)
+// - Applies the same protection to grenade explosions, one call per explosion
+// - Forces players to build in their team color
+// - Auto-restocks players when blocks < 10
+// - Adds /restock command
+// - Adds /clearabove, which clears the 5 cells above the player in one map
+//   update, with the same protection as destroying them without a spade
+// - Keeps a per-player record (from a pool) of denied actions
+//
+// Only the handlers implemented below are exported in the handler table, so a
+// version 2 server never needs to dispatch the others to this plugin.
+//
+// Build with:
+//   make PLUGIN_NAME=my_cpp_plugin PLUGIN_SOURCE=template_plugin.cpp
+
+#include "PluginSDK.hpp"
+
+#include <cstring>
+
+class BabelPlugin : public spadesx::Plugin<BabelPlugin>
+{
+  public:
+    int init(server_t* server)
+    {
+        denied_ = api().counter(server, "babel_cpp.denied_actions");
+
+        // Per-player records are optional, create() returns nullptr without a pool
+        if (!records_.init(api(), server, MAX_PLAYERS)) {
+            api().warning("Server does not provide object pools, per-player records disabled");
+        }
+
+        api().info("Loaded successfully!");
+        return 0;
+    }
+
+    void shutdown(server_t* server)
+    {
+        (void) server;
+        for (PlayerRecord*& record : players_) {
+            records_.destroy(record);
+            record = nullptr;
+        }
+        records_.reset();
+    }
+
+    void on_player_connect(server_t* server, const plugin_event_ctx_t& ctx)
+    {
+        (void) server;
+        if (ctx.player_id < MAX_PLAYERS) {
+            records_.destroy(players_[ctx.player_id]);
+            players_[ctx.player_id] = records_.create();
+        }
+    }
+
+    void on_player_disconnect(server_t* server, const plugin_event_ctx_t& ctx, const char* reason)
+    {
+        (void) server;
+        (void) reason;
+        if (ctx.player_id < MAX_PLAYERS) {
+            records_.destroy(players_[ctx.player_id]);
+            players_[ctx.player_id] = nullptr;
+        }
+    }
+
+    void on_server_init(server_t* server)
+    {
+        map_t* map = api().map(server);
+        if (!map) {
+            api().error("Map is NULL!");
+            return;
+        }
+
+        api().info("Creating platform...");
+        for (int32_t x = platform_top.x0; x <= platform_top.x1; x++) {
+            for (int32_t y = platform_top.y0; y <= platform_top.y1; y++) {
+                api().raw()->init_add_block(server, x, y, 1, 0xFF00FFFF); // Cyan
+            }
+        }
+    }
+
+    int on_block_destroy(server_t* server, const plugin_event_ctx_t& ctx, uint8_t tool, block_t& block)
+    {
+        (void) server;
+
+        if (is_platform(block)) {
+            return deny(ctx, "You should try to destroy the ennemy's tower... Not the platform!");
+        }
+
+        if (tool == TOOL_SPADE) {
+            return PLUGIN_ALLOW;
+        }
+
+        if (is_own_tower_side(ctx.team_id, block)) {
+            return deny(ctx, "You should try to destroy the ennemy's tower... It is not on this side of the map!");
+        }
+
+        return PLUGIN_ALLOW;
+    }
+
+    int on_block_place(server_t* server, const plugin_event_ctx_t& ctx, block_t& block)
+    {
+        block.color = ctx.team_color;
+
+        if (ctx.color != ctx.team_color) {
+            api().set_color(server, ctx.player, ctx.team_color);
+        }
+        if (ctx.blocks < 10) {
+            api().restock(ctx.player);
+        }
+
+        return PLUGIN_ALLOW;
+    }
+
+    // Same protection as on_block_destroy, one call per explosion
+    int on_grenade_impact(server_t* server, const plugin_event_ctx_t& thrower, plugin_grenade_impact_t& impact)
+    {
+        (void) server;
+        bool vetoed = false;
+
+        for (uint32_t i = 0; i < impact.block_count; i++) {
+            const block_t& block = impact.blocks[i];
+            if (is_platform(block) || is_own_tower_side(thrower.team_id, block)) {
+                PLUGIN_VETO_SET(impact.block_veto, i);
+                vetoed = true;
+            }
+        }
+
+        // One denied action per explosion, however many blocks it kept
+        if (vetoed) {
+            count_denied(thrower);
+        }
+
+        return PLUGIN_ALLOW;
+    }
+
+    int on_command(server_t* server, const plugin_event_ctx_t& ctx, const char* command)
+    {
+        if (std::strcmp(command, "/restock") == 0) {
+            api().restock(ctx.player);
+            api().notice(ctx.player, "Restocked!");
+            return PLUGIN_ALLOW;
+        }
+
+        if (std::strcmp(command, "/clearabove") == 0) {
+            if (ctx.team_id > 1) {
+                api().notice(ctx.player, "Join a team first!");
+                return PLUGIN_ALLOW;
+            }
+            clear_above(server, ctx);
+            api().notice(ctx.player, "Cleared the blocks above you!");
+            return PLUGIN_ALLOW;
+        }
+
+        return PLUGIN_DENY;
+    }
+
+  private:
+    static constexpr uint8_t MAX_PLAYERS = 32;
+
+    struct PlayerRecord
+    {
+        uint32_t denied = 0;
+    };
+
+    plugin_metric_t*            denied_ = nullptr;
+    spadesx::Pool<PlayerRecord> records_;
+    PlayerRecord*               players_[MAX_PLAYERS] = {};
+
+    // Tell the player, count the denial and return PLUGIN_DENY
+    int deny(const plugin_event_ctx_t& ctx, const char* message)
+    {
+        api().notice(ctx.player, message);
+        count_denied(ctx);
+        return PLUGIN_DENY;
+    }
+
+    // Count a denial in the metric and, if the player is still connected, their record
+    void count_denied(const plugin_event_ctx_t& ctx)
+    {
+        api().add(denied_);
+
+        PlayerRecord* record = ctx.player && ctx.player_id < MAX_PLAYERS ? players_[ctx.player_id] : nullptr;
+        if (record && ++record->denied % 10 == 0) {
+            api().info("%s has been denied %u times", ctx.name, record->denied);
+        }
+    }
+
+    // Platform layers (z = 0 and z = 2 on the inner area, z = 1 one block wider)
+    static constexpr spadesx::Region platform_top{206, 240, 0, 306, 272, 2};
+    static constexpr spadesx::Region platform_edge{205, 239, 1, 307, 273, 1};
+
+    // Each team's own half: team 0 tower on the left (x < 220), team 1 on the right (x > 292)
+    static constexpr spadesx::Region tower_side[2] = {{0, 0, 0, 219, 511, 63}, {293, 0, 0, 511, 511, 63}};
+
+    static constexpr bool is_platform(const block_t& block)
+    {
+        return platform_top.contains(block) || platform_edge.contains(block);
+    }
+
+    static constexpr bool is_own_tower_side(uint8_t team_id, const block_t& block)
+    {
+        return team_id < 2 && tower_side[team_id].contains(block);
+    }
+
+    // Remove the blocks in the 5 cells above the player with one read and one update,
+    // keeping those on_block_destroy protects from non-spade tools
+    void clear_above(server_t* server, const plugin_event_ctx_t& ctx)
+    {
+        int32_t x = static_cast<int32_t>(ctx.position.x);
+        int32_t y = static_cast<int32_t>(ctx.position.y);
+        int32_t z = static_cast<int32_t>(ctx.position.z);
+
+        block_t column[5];
+        for (int32_t i = 0; i < 5; i++) {
+            column[i] = block_t{x, y, z - 1 - i, 0};
+        }
+        api().get_blocks(api().map(server), column);
+
+        spadesx::BlockBatch<5> batch(api(), server);
+        for (const block_t& block : column) {
+            if (block.color != 0 && !is_platform(block) && !is_own_tower_side(ctx.team_id, block)) {
+                batch.remove(block.x, block.y, block.z);
+            }
+        }
+    }
+};
+
+SPADESX_PLUGIN(BabelPlugin,
+               "Example Gamemode (C++)",
+               "1.0.0",
+               "SpadesX Team",
+               "Babel-style gamemode with platform protection")